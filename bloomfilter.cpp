@@ -0,0 +1,105 @@
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "utils.h"
+
+/**
+ * @brief Filtro de Bloom concurrente y particionado en bloques de cache (64 bytes).
+ * Cada k-mer toca un solo bloque de 512 bits: la primera mitad registra la
+ * primera aparición y la segunda mitad la segunda, así una consulta cuesta
+ * un único fallo de cache en vez de W escrituras dispersas en el sketch.
+ */
+class BloomFilter {
+private:
+    static const int WORDS_PER_BLOCK = 8;   // 8 * 64 bits = una linea de cache
+    static const int WORDS_PER_LEVEL = 4;   // 256 bits por nivel
+    static const int NUM_PROBES = 4;        // bits por k-mer en cada nivel
+
+    uint64_t num_blocks;
+    std::vector<uint64_t> bits;
+    uint64_t seed; // Un solo hash: 32 bits altos para el bloque, 32 bajos para los bits
+
+    /**
+     * @brief Indica, sin escribir, si todos los bits del nivel ya están marcados.
+     */
+    bool is_set(const uint64_t* level, const uint64_t masks[]) const {
+        for (int w = 0; w < WORDS_PER_LEVEL; ++w) {
+            uint64_t word;
+            #pragma omp atomic read
+            word = level[w];
+            if ((word & masks[w]) != masks[w]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Marca los bits de un nivel del bloque de forma atómica.
+     * Primero lee cada palabra y solo hace el OR atómico si le falta algún bit,
+     * así los k-mers repetidos (ya marcados) no escriben sobre la línea compartida.
+     * @return true si todos los bits ya estaban marcados antes de la llamada.
+     */
+    bool test_and_set(uint64_t* level, const uint64_t masks[]) {
+        bool already_set = true;
+        for (int w = 0; w < WORDS_PER_LEVEL; ++w) {
+            if (masks[w] == 0) continue;
+            uint64_t old;
+            #pragma omp atomic read
+            old = level[w];
+            if ((old & masks[w]) == masks[w]) continue;
+
+            #pragma omp atomic capture
+            { old = level[w]; level[w] |= masks[w]; }
+            if ((old & masks[w]) != masks[w]) already_set = false;
+        }
+        return already_set;
+    }
+
+public:
+    /**
+     * @brief Constructor del filtro.
+     * @param total_bits Tamaño total en bits (potencia de 2, de 512 a 2^41).
+     */
+    BloomFilter(uint64_t total_bits) {
+        if (total_bits < 512 || total_bits > (1ULL << 41) || (total_bits & (total_bits - 1)) != 0) {
+            throw std::invalid_argument("El tamaño del filtro de Bloom debe ser una potencia de 2 entre 512 y 2^41.");
+        }
+        num_blocks = total_bits / 512;
+        bits.assign(num_blocks * WORDS_PER_BLOCK, 0);
+
+        std::random_device rd;
+        std::mt19937_64 gen(rd());
+        std::uniform_int_distribution<uint64_t> distrib;
+        seed = distrib(gen);
+    }
+
+    /**
+     * @brief Registra una aparición del k-mer.
+     * Los bits se marcan palabra por palabra, así que si varios hilos ven el mismo
+     * k-mer nuevo al mismo tiempo todos pueden recibir 0: esas apariciones
+     * concurrentes se pierden y no se corrigen (un k-mer que aparece dos veces,
+     * ambas a la vez, queda estimado en 0).
+     * @param kmer El k-mer codificado (uint64_t o kmer128).
+     * @return Apariciones previas: 0 (primera vez), 1 (segunda) o 2 (tercera o más).
+     */
+    template<typename KmerT>
+    int insert(const KmerT& kmer) {
+        uint64_t hash = fast_hash(kmer, seed);
+        uint64_t* block = &bits[((hash >> 32) & (num_blocks - 1)) * WORDS_PER_BLOCK];
+
+        // Cada posición usa 8 de los 32 bits bajos del hash (0-255 dentro del nivel)
+        uint64_t masks[WORDS_PER_LEVEL] = {0, 0, 0, 0};
+        for (int p = 0; p < NUM_PROBES; ++p) {
+            int pos = (hash >> (8 * p)) & 255;
+            masks[pos >> 6] |= 1ULL << (pos & 63);
+        }
+
+        // Camino rápido de los k-mers repetidos: el nivel 2 solo se marca con el
+        // nivel 1 completo, así que si ya está lleno basta con leerlo
+        if (is_set(block + WORDS_PER_LEVEL, masks)) return 2;
+
+        if (!test_and_set(block, masks)) return 0;
+        if (!test_and_set(block + WORDS_PER_LEVEL, masks)) return 1;
+        return 2;
+    }
+};
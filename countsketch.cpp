@@ -6,6 +6,7 @@
 #include <random>
 #include <fstream>
 #include <stdexcept>
+#include "utils.h"
 
 // Definimos el tipo de contador
 using CounterType = int32_t;
@@ -20,37 +21,6 @@ private:
     std::vector<uint64_t> seeds_h; // Para h(x) -> columna
     std::vector<uint64_t> seeds_g; // Para g(x) -> signo (+1 o -1)
 
-    /**
- * @brief Función de Hash rápida (MurmurHash3 Finalizer adaptado).
- * @param kmer La clave de 64 bits (el k-mer codificado).
- * @param seed La semilla de 64 bits (para independencia).
- * @return El valor de hash de 64 bits.
- */
-uint64_t fast_hash(uint64_t kmer, uint64_t seed) const {
-    // Constantes de MurmurHash3 para la mezcla de 64 bits
-    const uint64_t C1 = 0x87c37b91114253d5ULL;
-    const uint64_t C2 = 0x4cf5ad432745937fULL;
-    
-    uint64_t h = kmer ^ seed; // Inicializar con la clave y la semilla
-    
-    // --- Etapa de Mezcla (similar al finalizer de MurmurHash3) ---
-    
-    // Mezclar con C1 y rotación (similar a la mezcla del bloque de datos)
-    h ^= h >> 27;
-    h *= C1;
-    h ^= h >> 27;
-    h *= C2;
-    
-    // Mezcla final (avalancha) para asegurar una buena distribución
-    h ^= h >> 33; 
-    h *= 0xff51afd7ed558ccdULL; 
-    h ^= h >> 33; 
-    h *= 0xc4ceb9fe1a85ec53ULL; 
-    h ^= h >> 33;
-
-    return h;
-}
-
 public:
     /**
      * @brief Constructor de CountSketch.
@@ -75,9 +45,11 @@ public:
      * @brief Incrementa el contador para un k-mer dado.
      * NOTA: En la fase de paralelización, esta función debe ser llamada
      * con mecanismos de bloqueo (locks) si la matriz es compartida.
-     * @param kmer El k-mer codificado (uint64_t).
+     * @param kmer El k-mer codificado (uint64_t o kmer128).
+     * @param count Cantidad a sumar (por defecto 1).
      */
-    void update(uint64_t kmer) {
+    template<typename KmerT = uint64_t>
+    void update(const KmerT& kmer, CounterType count = 1) {
         for (int i = 0; i < W; ++i) {
             // 1. Obtener el índice de columna (0 a D-1)
             uint64_t hash_h = fast_hash(kmer, seeds_h[i]);
@@ -90,17 +62,18 @@ public:
             // 3. Actualizar el contador. 
             //matrix[i][column_index]++;
             #pragma omp atomic
-            matrix[i][column_index] += sign;
+            matrix[i][column_index] += sign * count;
         }
     }
 
     /**
      * @brief Estima la frecuencia de un k-mer.
      * La estimación es la mediana de las W entradas.
-     * @param kmer El k-mer codificado (uint64_t).
+     * @param kmer El k-mer codificado (uint64_t o kmer128).
      * @return La frecuencia estimada (CounterType).
      */
-    CounterType estimate(uint64_t kmer) const {
+    template<typename KmerT = uint64_t>
+    CounterType estimate(const KmerT& kmer) const {
         std::vector<CounterType> estimates;
         estimates.reserve(W);
 
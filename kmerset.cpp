@@ -0,0 +1,61 @@
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "utils.h"
+
+/**
+ * @brief Conjunto concurrente de k-mers (direccionamiento abierto, sondeo lineal).
+ * Guarda una palabra de 64 bits por k-mer: el propio código + 1 para uint64_t
+ * (0 marca una celda vacía) y una huella de 64 bits para kmer128.
+ * Con huellas de 64 bits la probabilidad de colisión es despreciable para un cromosoma.
+ */
+class KmerSet {
+private:
+    static const uint64_t SEED_POS = 0x9e3779b97f4a7c15ULL;
+    static const uint64_t SEED_HUELLA = 0xd1b54a32d192ed03ULL;
+
+    uint64_t capacidad; // Potencia de 2
+    std::unique_ptr<std::atomic<uint64_t>[]> celdas;
+
+    // Un k-mer canónico de k <= 32 nunca vale 2^64 - 1, así que +1 no desborda
+    static uint64_t clave(uint64_t kmer) { return kmer + 1; }
+    static uint64_t clave(const kmer128& kmer) { return fast_hash(kmer, SEED_HUELLA) | 1; }
+
+public:
+    /**
+     * @param max_elementos Cota superior de elementos distintos (ej: número de k-mers de la secuencia).
+     * Ocupa 8 * next_pow2(1.5 * max_elementos) bytes: 1 GB para ~58M k-mers, 2 GB para ~133M.
+     */
+    KmerSet(uint64_t max_elementos) {
+        // Factor de carga máximo ~2/3
+        capacidad = 1;
+        while (capacidad < max_elementos + max_elementos / 2 + 1) capacidad <<= 1;
+
+        celdas.reset(new std::atomic<uint64_t>[capacidad]);
+        #pragma omp parallel for schedule(static)
+        for (uint64_t i = 0; i < capacidad; ++i) {
+            celdas[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Inserta el k-mer si no estaba.
+     * @return true solo para el hilo que lo insertó por primera vez.
+     */
+    template<typename KmerT>
+    bool insert(const KmerT& kmer) {
+        uint64_t c = clave(kmer);
+        uint64_t pos = fast_hash(c, SEED_POS) & (capacidad - 1);
+
+        while (true) {
+            uint64_t actual = celdas[pos].load(std::memory_order_relaxed);
+            if (actual == c) return false;
+            if (actual == 0) {
+                uint64_t esperado = 0;
+                if (celdas[pos].compare_exchange_strong(esperado, c, std::memory_order_relaxed)) return true;
+                if (esperado == c) return false;
+            }
+            pos = (pos + 1) & (capacidad - 1);
+        }
+    }
+};
@@ -11,6 +11,9 @@ namespace fs = std::filesystem;
 // Configuracion por defecto
 int D = 1 << 26; 
 int W = 5;
+uint64_t B = 0; // Bits del filtro de Bloom por k (0 = desactivado)
+size_t TOP_K = 20; // Heavy hitters por k en modo spectrum
+const long long MAX_TOP_K = 1000000;
 std::vector<int> k_values = {15, 21, 31};
 
 // Archivos
@@ -18,6 +21,7 @@ const std::string STRUCTURE_FILE = "multi_countsketch_human_genome.bin";
 const std::string DATASET_FOLDER = "datasets";
 const std::string CSV_OUTPUT_DIR = "plots/csv";
 const std::string CSV_FILENAME = "resultados_scores.csv";
+const std::string HEAVY_HITTERS_DIR = "plots/csv/heavy_hitters";
 
 // Elimina espacios y llaves {} de un string
 std::string clean_string(std::string s) {
@@ -75,13 +79,15 @@ std::vector<std::string> obtener_archivos(const std::string& ruta) {
 void print_usage(const char* progName) {
     std::cout << "Uso: " << progName << " <modo> [opciones]\n"
               << "Modos:\n"
-              << "  train, score, both\n"
+              << "  count, score, both, spectrum\n"
               << "Opciones Requeridas:\n"
-              << "  -k {k1,k2...}   Lista de k-mers (ej: 15,21,31)\n"
+              << "  -k {k1,k2...}   Lista de k-mers (ej: 15,21,31), maximo 63\n"
               << "  -d <num>        Dimension D para el sketch (columnas, ej: 67108864)\n"
               << "  -w <num>        Ancho W para el sketch (filas/hashes, ej: 5)\n"
               << "Opciones Opcionales:\n"
-              << "  -p {p1,p2...}   Pesos para scoring (ej: 1.0,1.0,1.5). Default: todos 1.0\n";
+              << "  -p {p1,p2...}   Pesos para scoring (ej: 1.0,1.0,1.5). Default: todos 1.0\n"
+              << "  -b <num>        Bits del filtro de Bloom por k para descartar k-mers unicos (potencia de 2, ej: 1073741824). Default: 0 (sin filtro)\n"
+              << "  -t <num>        Heavy hitters por k en modo spectrum (0 a 1000000). Default: 20\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -91,7 +97,7 @@ int main(int argc, char* argv[]) {
     }
 
     std::string mode = argv[1];
-    if (mode != "count" && mode != "score" && mode != "both") {
+    if (mode != "count" && mode != "score" && mode != "both" && mode != "spectrum") {
         std::cerr << "Error: Modo desconocido '" << mode << "'\n";
         print_usage(argv[0]);
         return 1;
@@ -110,6 +116,15 @@ int main(int argc, char* argv[]) {
                 W = std::stoi(argv[++i]);
             } else if (arg == "-p") {
                 pesos = parse_double_list(argv[++i]);
+            } else if (arg == "-b") {
+                B = std::stoull(argv[++i]);
+            } else if (arg == "-t") {
+                long long top_k = std::stoll(argv[++i]);
+                if (top_k < 0 || top_k > MAX_TOP_K) {
+                    std::cerr << "Error: -t debe estar entre 0 y " << MAX_TOP_K << "." << std::endl;
+                    return 1;
+                }
+                TOP_K = top_k;
             }
         }
     }
@@ -120,7 +135,22 @@ int main(int argc, char* argv[]) {
             return 1;
     }
 
-    multi_countsketch mcs(k_values.size(), k_values.data(), W, D);
+    for (int k : k_values) {
+        if (k < 1 || k > MAX_K) {
+            std::cerr << "Error: k=" << k << " fuera de rango (1 a " << MAX_K << ")." << std::endl;
+            return 1;
+        }
+    }
+
+    if (B != 0 && (B < 512 || B > (1ULL << 41) || (B & (B - 1)) != 0)) {
+        std::cerr << "Error: -b debe ser una potencia de 2 entre 512 y 2^41." << std::endl;
+        return 1;
+    }
+
+    // El filtro solo se usa al contar y no se guarda en el .bin
+    bool cuenta = (mode == "count" || mode == "both");
+    bool usa_filtro = cuenta || mode == "spectrum";
+    multi_countsketch mcs(k_values.size(), k_values.data(), W, D, usa_filtro ? B : 0);
 
     std::vector<std::string> archivos = obtener_archivos(DATASET_FOLDER);
 
@@ -130,7 +160,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Conteo
-    if (mode == "conteo" || mode == "both") {
+    if (cuenta) {
         std::cout << "Iniciando conteo" << std::endl;
         auto start = std::chrono::high_resolution_clock::now();
 
@@ -139,6 +169,7 @@ int main(int argc, char* argv[]) {
         auto end = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> elapsed = end - start;
         std::cout << "Conteo completado en " << elapsed.count() << " segundos." << std::endl;
+        if (B > 0) mcs.imprimir_estadisticas_filtro();
 
         // Guardar estructura
         mcs.save_structure(STRUCTURE_FILE);
@@ -203,5 +234,57 @@ int main(int argc, char* argv[]) {
         std::cout << "Resultados guardados en: " << csv_path << std::endl;
     }
 
+    if (mode == "spectrum") {
+        std::cout << "Calculando espectro estimado" << std::endl;
+        fs::create_directories(HEAVY_HITTERS_DIR);
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (const auto& path : archivos) {
+            lectordatasets lector(path);
+            std::string secuencia = lector.leerTexto();
+            std::string filename = fs::path(path).filename().string();
+            std::cout << "Procesando: " << filename << std::endl;
+
+            // Sketch propio del archivo: las frecuencias deben ser las de este cromosoma
+            mcs.reiniciar();
+            mcs.update(secuencia);
+
+            for (size_t i = 0; i < k_values.size(); ++i) {
+                int k = k_values[i];
+                espectro_estimado espectro = mcs.calcular_espectro(secuencia, i, TOP_K);
+
+                // Mismo formato que los ground truth para plots/grapher.py
+                std::string spectrum_path = CSV_OUTPUT_DIR + "/sketch_k" + std::to_string(k) + "_" + filename + ".csv";
+                std::ofstream spectrumFile(spectrum_path);
+                if (!spectrumFile.is_open()) {
+                    std::cerr << "Error al crear el archivo CSV en " << spectrum_path << std::endl;
+                    return 1;
+                }
+                spectrumFile << "Frecuencia,Conteo" << std::endl;
+                for (const auto& [frecuencia, conteo] : espectro.histograma) {
+                    spectrumFile << frecuencia << "," << conteo << std::endl;
+                }
+
+                std::string top_path = HEAVY_HITTERS_DIR + "/top_k" + std::to_string(k) + "_" + filename + ".csv";
+                std::ofstream topFile(top_path);
+                if (!topFile.is_open()) {
+                    std::cerr << "Error al crear el archivo CSV en " << top_path << std::endl;
+                    return 1;
+                }
+                topFile << "Kmer,Frecuencia" << std::endl;
+                for (const auto& [kmer, frecuencia] : espectro.heavy_hitters) {
+                    topFile << kmer << "," << frecuencia << std::endl;
+                }
+
+                std::cout << "  k=" << k << ": " << spectrum_path << ", " << top_path << std::endl;
+            }
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed = end - start;
+        std::cout << "Espectro completado en " << elapsed.count() << " segundos." << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "countsketch.cpp"
+#include "bloomfilter.cpp"
+#include "kmerset.cpp"
 #include "lector.cpp"
 #include "utils.h"
 #include <filesystem>
@@ -11,26 +13,250 @@
 #include <mutex>
 #include <omp.h>
 #include <memory>
-
+#include <map>
+#include <unordered_map>
+#include <queue>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @brief Espectro de frecuencias estimado desde el sketch para un k.
+ */
+struct espectro_estimado {
+    std::map<CounterType, long long> histograma; // Frecuencia -> Conteo de k-mers distintos
+    std::vector<std::pair<std::string, CounterType>> heavy_hitters; // De mayor a menor frecuencia
+};
 
 class multi_countsketch {
 private:
     std::vector<CountSketch> multi;
+    std::vector<BloomFilter> filtros; // Vacío si el pre-filtro está desactivado
+    std::vector<long long> escrituras_sketch; // k-mers enviados al sketch, por k
+    std::vector<long long> kmers_filtrados;   // k-mers retenidos por el filtro, por k
     std::vector<int> K_S;
     std::vector<std::string> dataset_files;
     std::string archivo_actual;
     int N;
     int W;
     int D;
+    uint64_t B; // Bits de cada filtro de Bloom (0 = sin filtro)
+
+    /**
+     * @brief Envía un k-mer al sketch, pasando antes por el filtro de Bloom si está activo.
+     */
+    template<typename KmerT>
+    static void contar_kmer(CountSketch& sketch, BloomFilter* filtro, const KmerT& kmer,
+                            long long& escritos, long long& filtrados) {
+        if (filtro == nullptr) {
+            sketch.update(kmer);
+            escritos++;
+            return;
+        }
+
+        int vistas = filtro->insert(kmer);
+        if (vistas == 0) {
+            filtrados++;
+            return;
+        }
+        sketch.update(kmer, vistas == 1 ? 2 : 1);
+        escritos++;
+    }
+
+    /**
+     * @brief Tramo [inicio, fin) de posiciones de k-mer que le toca al hilo actual.
+     * Debe llamarse dentro de una región paralela.
+     */
+    static std::pair<size_t, size_t> tramo_hilo(size_t total) {
+        size_t hilos = omp_get_num_threads();
+        size_t id = omp_get_thread_num();
+        return {total * id / hilos, total * (id + 1) / hilos};
+    }
+
+    /**
+     * @brief Cuenta los k-mers de longitud K_S[i] con la codificación KmerT.
+     * Con uint64_t (k <= 32) cada posición se codifica por separado, como siempre.
+     * Con kmer128 cada hilo recorre un tramo contiguo con rolling_encoder,
+     * así cada k-mer cuesta una base nueva en vez de k.
+     */
+    template<typename KmerT>
+    void update_k(int i, const std::string& secuencia) {
+        int k = K_S[i];
+
+        // Obtener referencias locales al objeto 
+        CountSketch& current_sketch = multi[i];
+        BloomFilter* filtro = filtros.empty() ? nullptr : &filtros[i];
+        size_t seq_len = secuencia.length();
+        long long escritos = 0;
+        long long filtrados = 0;
+
+        if constexpr (std::is_same_v<KmerT, uint64_t>) {
+            // Paralelizar el procesamiento de k-mers
+            #pragma omp parallel for reduction(+:escritos, filtrados) schedule(static)
+            for (size_t j = 0; j <= seq_len - k; ++j) {
+
+                std::string_view kmer_str = std::string_view(secuencia).substr(j, k);
+                uint64_t encoded_kmer = encode_kmer(kmer_str); 
+                
+                contar_kmer(current_sketch, filtro, encoded_kmer, escritos, filtrados);
+            }
+        } else {
+            #pragma omp parallel reduction(+:escritos, filtrados)
+            {
+                auto [inicio, fin] = tramo_hilo(seq_len - k + 1);
+                if (inicio < fin) {
+                    rolling_encoder encoder(k);
+                    for (size_t p = inicio; p < inicio + k - 1; ++p) encoder.push(secuencia[p]);
+
+                    for (size_t j = inicio; j < fin; ++j) {
+                        encoder.push(secuencia[j + k - 1]);
+                        contar_kmer(current_sketch, filtro, encoder.canonical(), escritos, filtrados);
+                    }
+                }
+            }
+        }
+
+        escrituras_sketch[i] += escritos;
+        kmers_filtrados[i] += filtrados;
+    }
+
+    /**
+     * @brief Suma de Z-Scores y cantidad de k-mers de la secuencia para el sketch i.
+     * Misma separación por tipo que update_k.
+     */
+    template<typename KmerT>
+    std::pair<double, long long> sumar_z_scores(int i, const std::string& secuencia, double mu_k, double inv_sigma_k) {
+        int k = K_S[i];
+        double sum_z_scores = 0.0;
+        long long num_kmers = 0;
+
+        if constexpr (std::is_same_v<KmerT, uint64_t>) {
+            int max_j = secuencia.length() - k;
+            #pragma omp parallel for reduction(+:sum_z_scores, num_kmers) schedule(static)
+            for (size_t j = 0; j <= max_j; ++j) {
+                std::string_view kmer_str = std::string_view(secuencia).substr(j, k);
+                uint64_t encoded_kmer = encode_kmer(kmer_str);
+
+                CounterType f_hat = multi[i].estimate(encoded_kmer);
+                double z_score = (static_cast<double>(f_hat) - mu_k) * inv_sigma_k;
+                
+                sum_z_scores += z_score;
+                num_kmers++;
+            }
+        } else {
+            #pragma omp parallel reduction(+:sum_z_scores, num_kmers)
+            {
+                auto [inicio, fin] = tramo_hilo(secuencia.length() - k + 1);
+                if (inicio < fin) {
+                    rolling_encoder encoder(k);
+                    for (size_t p = inicio; p < inicio + k - 1; ++p) encoder.push(secuencia[p]);
+
+                    for (size_t j = inicio; j < fin; ++j) {
+                        encoder.push(secuencia[j + k - 1]);
+                        CounterType f_hat = multi[i].estimate(encoder.canonical());
+                        sum_z_scores += (static_cast<double>(f_hat) - mu_k) * inv_sigma_k;
+                        num_kmers++;
+                    }
+                }
+            }
+        }
+
+        return {sum_z_scores, num_kmers};
+    }
+
+    /**
+     * @brief Recorre la secuencia una vez, consultando el sketch i para cada k-mer distinto.
+     * Cada hilo arma su propio histograma y su min-heap de tamaño top_k, y al final
+     * se combinan. Un k-mer lo procesa solo el hilo que lo inserta en el KmerSet.
+     */
+    template<typename KmerT>
+    espectro_estimado espectro_k(int i, const std::string& secuencia, size_t top_k) {
+        int k = K_S[i];
+        size_t num_kmers = secuencia.length() - k + 1;
+        KmerSet vistos(num_kmers);
+
+        espectro_estimado resultado;
+        std::vector<std::pair<CounterType, size_t>> candidatos; // {frecuencia, posición}
+
+        #pragma omp parallel
+        {
+            std::unordered_map<CounterType, long long> hist_local;
+            // Min-heap: en el tope queda el menor de los top_k actuales
+            std::priority_queue<std::pair<CounterType, size_t>,
+                                std::vector<std::pair<CounterType, size_t>>,
+                                std::greater<std::pair<CounterType, size_t>>> heap;
+
+            auto procesar = [&](size_t j, const KmerT& kmer) {
+                if (!vistos.insert(kmer)) return;
+
+                // Todo k-mer presente aparece al menos una vez
+                CounterType f_hat = std::max<CounterType>(multi[i].estimate(kmer), 1);
+                hist_local[f_hat]++;
+
+                if (top_k == 0) return;
+                if (heap.size() < top_k) {
+                    heap.emplace(f_hat, j);
+                } else if (f_hat > heap.top().first) {
+                    heap.pop();
+                    heap.emplace(f_hat, j);
+                }
+            };
+
+            if constexpr (std::is_same_v<KmerT, uint64_t>) {
+                #pragma omp for schedule(static)
+                for (size_t j = 0; j < num_kmers; ++j) {
+                    std::string_view kmer_str = std::string_view(secuencia).substr(j, k);
+                    procesar(j, encode_kmer(kmer_str));
+                }
+            } else {
+                auto [inicio, fin] = tramo_hilo(num_kmers);
+                if (inicio < fin) {
+                    rolling_encoder encoder(k);
+                    for (size_t p = inicio; p < inicio + k - 1; ++p) encoder.push(secuencia[p]);
+
+                    for (size_t j = inicio; j < fin; ++j) {
+                        encoder.push(secuencia[j + k - 1]);
+                        procesar(j, encoder.canonical());
+                    }
+                }
+            }
+
+            #pragma omp critical
+            {
+                for (const auto& [frecuencia, conteo] : hist_local) resultado.histograma[frecuencia] += conteo;
+                while (!heap.empty()) {
+                    candidatos.push_back(heap.top());
+                    heap.pop();
+                }
+            }
+        }
+
+        std::sort(candidatos.begin(), candidatos.end(), std::greater<std::pair<CounterType, size_t>>());
+        if (candidatos.size() > top_k) candidatos.resize(top_k);
+        for (const auto& [frecuencia, pos] : candidatos) {
+            resultado.heavy_hitters.emplace_back(canonical_string(std::string_view(secuencia).substr(pos, k)), frecuencia);
+        }
+        return resultado;
+    }
 
 public:
-    multi_countsketch(int n, const int k_s[], int w, int d) : N(n), W(w), D(d) {
+    /**
+     * @param bloom_bits Tamaño en bits del filtro de Bloom por k. Si es 0 no se filtra
+     * y cada k-mer va directo al sketch; si no, solo se envía desde su segunda aparición.
+     */
+    multi_countsketch(int n, const int k_s[], int w, int d, uint64_t bloom_bits = 0) : N(n), W(w), D(d), B(bloom_bits) {
         
         // Inicializar K_S (longitudes de k)
         K_S.assign(k_s, k_s + N);
 
         // Construir CountSketches y agregarlos al vector
         for (int i = 0; i < N; i++) multi.emplace_back(W, D); 
+        if (bloom_bits > 0) {
+            for (int i = 0; i < N; i++) filtros.emplace_back(bloom_bits);
+        }
+        escrituras_sketch.assign(N, 0);
+        kmers_filtrados.assign(N, 0);
         
         try {
             for (const auto& entry : std::filesystem::recursive_directory_iterator("datasets")) {
@@ -41,6 +267,21 @@ public:
         }
     }
 
+    /**
+     * @brief Deja los sketches (y filtros) vacíos, con semillas nuevas,
+     * para contar una secuencia por separado.
+     */
+    void reiniciar() {
+        multi.clear();
+        filtros.clear();
+        for (int i = 0; i < N; i++) multi.emplace_back(W, D);
+        if (B > 0) {
+            for (int i = 0; i < N; i++) filtros.emplace_back(B);
+        }
+        escrituras_sketch.assign(N, 0);
+        kmers_filtrados.assign(N, 0);
+    }
+
     /**
      * @brief Retorna la siguiente secuencia del dataset.
      */
@@ -63,6 +304,8 @@ public:
     /**
      * @brief Procesa la secuencia dada, actualizando todos los CountSketches 
      * (uno por cada k) en paralelo.
+     * Con el pre-filtro activo, la primera aparición de un k-mer solo queda en el
+     * filtro de Bloom; en la segunda se suma 2 al sketch para compensar la cuenta omitida.
      * @param secuencia La cadena de ADN/ARN a procesar.
      */
     void update(std::string& secuencia){
@@ -74,19 +317,22 @@ public:
             // Verificar longitud mínima para evitar underflow
             if (secuencia.length() < k) continue; 
             
-            // Obtener referencias locales al objeto 
-            CountSketch& current_sketch = multi[i];
-            size_t seq_len = secuencia.length();
-            
-            // Paralelizar el procesamiento de k-mers
-            #pragma omp parallel for schedule(static)
-            for (size_t j = 0; j <= seq_len - k; ++j) {
+            if (k <= 32) update_k<uint64_t>(i, secuencia);
+            else update_k<kmer128>(i, secuencia);
+        }
+    }
 
-                std::string_view kmer_str = std::string_view(secuencia).substr(j, k);
-                uint64_t encoded_kmer = encode_kmer(kmer_str); 
-                
-                current_sketch.update(encoded_kmer); 
-            }
+    /**
+     * @brief Imprime, por cada k, cuántos k-mers llegaron al sketch y cuántos
+     * retuvo el filtro de Bloom (escrituras ahorradas = filtrados * W).
+     */
+    void imprimir_estadisticas_filtro() const {
+        for (int i = 0; i < N; ++i) {
+            long long total = escrituras_sketch[i] + kmers_filtrados[i];
+            double reduccion = (total > 0) ? (100.0 * kmers_filtrados[i] / total) : 0.0;
+            std::cout << "k=" << K_S[i] << ": " << escrituras_sketch[i] << " k-mers enviados al sketch, "
+                      << kmers_filtrados[i] << " retenidos por el filtro ("
+                      << reduccion << "% menos escrituras)" << std::endl;
         }
     }
 
@@ -100,6 +346,7 @@ public:
         if (index < 0 || index >= N) {
             throw std::out_of_range("Index out of range in multi_countsketch::estimate");
         }
+        if (K_S[index] > 32) return multi[index].estimate(encode_canonical<kmer128>(kmer_str));
         uint64_t encoded_kmer = encode_kmer(kmer_str);
         return multi[index].estimate(encoded_kmer);
     }
@@ -145,21 +392,9 @@ public:
             if (sigma_k == 0.0) sigma_k = 1.0; 
             double inv_sigma_k = 1.0 / sigma_k;
 
-            double sum_z_scores = 0.0;
-            long long num_kmers = 0;
-
-            int max_j = secuencia.length() - k;
-            #pragma omp parallel for reduction(+:sum_z_scores, num_kmers) schedule(static)
-            for (size_t j = 0; j <= max_j; ++j) {
-                std::string_view kmer_str = std::string_view(secuencia).substr(j, k);
-                uint64_t encoded_kmer = encode_kmer(kmer_str);
-
-                CounterType f_hat = multi[i].estimate(encoded_kmer);
-                double z_score = (static_cast<double>(f_hat) - mu_k) * inv_sigma_k;
-                
-                sum_z_scores += z_score;
-                num_kmers++;
-            }
+            auto [sum_z_scores, num_kmers] = (k <= 32)
+                ? sumar_z_scores<uint64_t>(i, secuencia, mu_k, inv_sigma_k)
+                : sumar_z_scores<kmer128>(i, secuencia, mu_k, inv_sigma_k);
 
             double average_z_score = (num_kmers > 0) ? (sum_z_scores / num_kmers) : 0.0;
             total_score += w_k * average_z_score;
@@ -168,6 +403,26 @@ public:
         return total_score;
     }
 
+    /**
+     * @brief Calcula el espectro de frecuencias estimado y los k-mers más repetidos
+     * de la secuencia, sin contador exacto: los k-mers distintos se deduplican con
+     * un KmerSet y su frecuencia se consulta al CountSketch correspondiente.
+     * El sketch debe contener solo esta secuencia (ver reiniciar()) para que las
+     * frecuencias correspondan a ella y no a todo el dataset.
+     * @param secuencia La secuencia a analizar.
+     * @param index Índice del CountSketch (0 a N-1).
+     * @param top_k Cantidad de heavy hitters a reportar.
+     * @return Histograma Frecuencia -> Conteo y heavy hitters ordenados.
+     */
+    espectro_estimado calcular_espectro(const std::string& secuencia, int index, size_t top_k) {
+        if (index < 0 || index >= N) {
+            throw std::out_of_range("Index out of range in multi_countsketch::calcular_espectro");
+        }
+        if (secuencia.length() < static_cast<size_t>(K_S[index])) return {};
+        if (K_S[index] > 32) return espectro_k<kmer128>(index, secuencia, top_k);
+        return espectro_k<uint64_t>(index, secuencia, top_k);
+    }
+
     /**
      * @brief Guarda toda la estructura en un archivo .bin
      */
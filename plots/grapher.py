@@ -43,6 +43,9 @@ def plot_multi_k_comparison():
             
             if not c_key: continue 
 
+            # Espectros estimados por mcsketch spectrum: linea discontinua
+            es_sketch = filename.startswith("sketch_")
+
             try:
                 df = pd.read_csv(f)
             except Exception as e:
@@ -56,7 +59,8 @@ def plot_multi_k_comparison():
 
             ax.loglog(df["Frecuencia"], df["Probabilidad"], 
                       color=chromosomes_meta[c_key]['color'],
-                      label=chromosomes_meta[c_key]['label'] if i == 0 else "", #
+                      label=(chromosomes_meta[c_key]['label'] + (" (sketch)" if es_sketch else "")) if i == 0 else "", #
+                      linestyle='--' if es_sketch else '-',
                       linewidth=2, alpha=0.8)
 
         ax.set_title(f"Longitud K = {k}", fontsize=14, fontweight='bold')
@@ -4,6 +4,7 @@
 #include <string>
 #include <algorithm>
 #include <cstdint>
+#include <stdexcept>
 
 inline uint64_t base_to_int(char base) {
     switch (base) {
@@ -14,6 +15,101 @@ inline uint64_t base_to_int(char base) {
     }
 }
 
+/**
+ * @brief Función de Hash rápida (MurmurHash3 Finalizer adaptado).
+ * @param kmer La clave de 64 bits (el k-mer codificado).
+ * @param seed La semilla de 64 bits (para independencia).
+ * @return El valor de hash de 64 bits.
+ */
+inline uint64_t fast_hash(uint64_t kmer, uint64_t seed) {
+    // Constantes de MurmurHash3 para la mezcla de 64 bits
+    const uint64_t C1 = 0x87c37b91114253d5ULL;
+    const uint64_t C2 = 0x4cf5ad432745937fULL;
+    
+    uint64_t h = kmer ^ seed; // Inicializar con la clave y la semilla
+    
+    // --- Etapa de Mezcla (similar al finalizer de MurmurHash3) ---
+    
+    // Mezclar con C1 y rotación (similar a la mezcla del bloque de datos)
+    h ^= h >> 27;
+    h *= C1;
+    h ^= h >> 27;
+    h *= C2;
+    
+    // Mezcla final (avalancha) para asegurar una buena distribución
+    h ^= h >> 33; 
+    h *= 0xff51afd7ed558ccdULL; 
+    h ^= h >> 33; 
+    h *= 0xc4ceb9fe1a85ec53ULL; 
+    h ^= h >> 33;
+
+    return h;
+}
+
+/**
+ * @brief K-mer codificado en dos palabras (128 bits), para 32 < k <= 63.
+ * hi guarda las bases más significativas y lo las últimas 32.
+ */
+struct kmer128 {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool operator<(const kmer128& other) const {
+        return hi != other.hi ? hi < other.hi : lo < other.lo;
+    }
+    bool operator==(const kmer128& other) const {
+        return hi == other.hi && lo == other.lo;
+    }
+};
+
+// Longitud máxima de k soportada por la codificación de 128 bits
+const int MAX_K = 63;
+
+/**
+ * @brief Hash de un k-mer de 128 bits: mezcla la palabra alta y la combina con la baja.
+ */
+inline uint64_t fast_hash(const kmer128& kmer, uint64_t seed) {
+    return fast_hash(kmer.lo ^ fast_hash(kmer.hi, seed), seed);
+}
+
+/**
+ * @brief Desplaza una base en la codificación forward y en la reverso complementaria
+ * de 128 bits (k de 33 a 63): el acarreo pasa entre lo y hi.
+ * @param val La base nueva (0-3).
+ */
+inline void roll_base(kmer128& fwd, kmer128& rc, uint64_t val, int k) {
+    int hi_bits = 2 * k - 64;
+    uint64_t hi_mask = (hi_bits == 64) ? ~0ULL : ((1ULL << hi_bits) - 1);
+    fwd.hi = ((fwd.hi << 2) | (fwd.lo >> 62)) & hi_mask;
+    fwd.lo = (fwd.lo << 2) | val;
+
+    rc.lo = (rc.lo >> 2) | (rc.hi << 62);
+    rc.hi = (rc.hi >> 2) | ((val ^ 3) << (hi_bits - 2));
+}
+
+/**
+ * @brief Codificación canónica incremental de 128 bits (k de 33 a 63): cada push
+ * agrega una base a la derecha y actualiza ambos sentidos en O(1), sin recorrer
+ * el k-mer completo. Para k <= 32 se mantiene encode_kmer por posición.
+ */
+class rolling_encoder {
+private:
+    int k;
+    kmer128 fwd{};
+    kmer128 rc{};
+
+public:
+    explicit rolling_encoder(int k_) : k(k_) {
+        if (k < 33 || k > MAX_K) {
+            throw std::invalid_argument("rolling_encoder solo admite k entre 33 y 63.");
+        }
+    }
+
+    void push(char base) { roll_base(fwd, rc, base_to_int(base), k); }
+
+    kmer128 canonical() const { return std::min(fwd, rc); }
+};
+
 uint64_t encode_kmer(std::string_view kmer_str) {
     uint64_t kmer_code = 0;
     uint64_t rc_code = 0;
@@ -42,4 +138,40 @@ uint64_t encode_kmer(std::string_view kmer_str) {
     return std::min(kmer_code, rc_code);
 }
 
+/**
+ * @brief Forma canónica de un k-mer como texto (el menor entre él y su reverso complementario).
+ * Coincide con encode_kmer porque A < C < G < T conserva el orden lexicográfico.
+ */
+inline std::string canonical_string(std::string_view kmer_str) {
+    std::string rc(kmer_str.rbegin(), kmer_str.rend());
+    for (char& base : rc) {
+        switch (base) {
+            case 'A': base = 'T'; break;
+            case 'C': base = 'G'; break;
+            case 'G': base = 'C'; break;
+            default: base = 'A'; break;
+        }
+    }
+    return std::min(std::string(kmer_str), rc);
+}
+
+/**
+ * @brief Codificación canónica de un k-mer completo según el tipo elegido.
+ * Para uint64_t se usa encode_kmer tal cual.
+ */
+template<typename KmerT>
+KmerT encode_canonical(std::string_view kmer_str);
+
+template<>
+inline uint64_t encode_canonical<uint64_t>(std::string_view kmer_str) {
+    return encode_kmer(kmer_str);
+}
+
+template<>
+inline kmer128 encode_canonical<kmer128>(std::string_view kmer_str) {
+    rolling_encoder encoder(kmer_str.size());
+    for (char base : kmer_str) encoder.push(base);
+    return encoder.canonical();
+}
+
 #endif
\ No newline at end of file